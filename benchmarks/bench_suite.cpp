@@ -0,0 +1,642 @@
+// bench_suite.cpp
+//
+// Single driver for the queue and matmul benchmarks. Sweeps queue capacity,
+// payload size, producer/consumer cpu placement and matrix shapes, pins its own
+// threads, optionally writes JSON and compares against a stored baseline. The
+// alloc group compares std::allocator with memory::AlignedAllocator variants.
+//
+//   ./bench_suite --json out.json --baseline benchmarks/baseline.json --threshold 0.10
+//
+// Exit code is 2 if any case regressed beyond the threshold, 3 if no case regressed
+// but baseline cases are missing from this run (filtered out, renamed or skipped
+// because pinning failed).
+#include <Tachyon/linalg/MatMul.h>
+#include <Tachyon/memory/AlignedAllocator.h>
+#include <Tachyon/queues/SPSCQueue.h>
+#include <Tachyon/ring/RingBufferFixed.h>
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using Tachyon::memory::AlignedAllocator;
+using Tachyon::memory::PageMode;
+using Tachyon::queues::SPSCQueue;
+using Tachyon::ring::RingBufferFixed;
+
+namespace {
+
+// Fixed-size trivially copyable payload; only the first word carries data.
+template<size_t N>
+struct Payload {
+    static_assert(N >= sizeof(size_t), "payload must hold a size_t");
+    std::array<unsigned char, N> bytes;
+
+    Payload() = default;
+    explicit Payload(size_t i) { std::memcpy(bytes.data(), &i, sizeof(i)); }
+};
+
+struct CpuPair { int producer; int consumer; };
+struct Shape { size_t M, N, K; };
+
+struct Options {
+    size_t iterations = 2'000'000;
+    int reps = 5;
+    std::vector<size_t> capacities = {64, 1024, 65536};
+    std::vector<size_t> payloads = {8, 64, 256};
+    std::vector<CpuPair> cpus;
+    std::vector<Shape> shapes = {{128, 128, 128}, {256, 256, 256}, {512, 512, 512}, {256, 1024, 128}};
+    size_t alloc_capacity = 1 << 20;
+    Shape alloc_shape = {1024, 1024, 1024};
+    bool run_queues = true;
+    bool run_matmul = true;
+    bool run_alloc = true;
+    std::string json_path;
+    std::string baseline_path;
+    double threshold = 0.10;
+};
+
+struct Record {
+    std::string name;
+    std::string metric;
+    double value;
+    bool lower_is_better;
+};
+
+// --- CLI parsing ---
+
+std::vector<std::string> split(const std::string& s, char sep) {
+    std::vector<std::string> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, sep))
+        if (!item.empty()) out.push_back(item);
+    return out;
+}
+
+std::vector<size_t> parse_sizes(const std::string& s) {
+    std::vector<size_t> out;
+    for (const auto& t : split(s, ',')) out.push_back(std::stoul(t));
+    return out;
+}
+
+std::vector<CpuPair> parse_cpus(const std::string& s) {
+    std::vector<CpuPair> out;
+    for (const auto& t : split(s, ',')) {
+        auto p = split(t, ':');
+        if (p.size() != 2) throw std::invalid_argument("cpu pair must be P:C, got " + t);
+        out.push_back({std::stoi(p[0]), std::stoi(p[1])});
+    }
+    return out;
+}
+
+std::vector<Shape> parse_shapes(const std::string& s) {
+    std::vector<Shape> out;
+    for (const auto& t : split(s, ',')) {
+        auto d = split(t, 'x');
+        if (d.size() == 1) out.push_back({std::stoul(d[0]), std::stoul(d[0]), std::stoul(d[0])});
+        else if (d.size() == 3) out.push_back({std::stoul(d[0]), std::stoul(d[1]), std::stoul(d[2])});
+        else throw std::invalid_argument("shape must be N or MxNxK, got " + t);
+    }
+    return out;
+}
+
+void usage(const char* prog) {
+    std::cout
+        << "usage: " << prog << " [options]\n"
+        << "  --iters N           queue iterations per run (default 2000000)\n"
+        << "  --reps N            repetitions per case, median is reported (default 5)\n"
+        << "  --caps a,b,...      queue storage slots, >= 2; one slot stays empty (default 64,1024,65536)\n"
+        << "  --payloads a,b,...  payload sizes in bytes: 8,16,64,256 (default 8,64,256)\n"
+        << "  --cpus P:C,...      producer:consumer cpu pairs, -1 = unpinned; P == C skips SPSC cases\n"
+        << "  --shapes MxNxK,...  matmul shapes, or N for square (default 128,256,512,256x1024x128)\n"
+        << "  --alloc-cap N       queue storage slots for the alloc group, >= 2 (default 1048576)\n"
+        << "  --alloc-shape MxNxK matmul shape for the alloc group (default 1024)\n"
+        << "  --only GROUP        run a single group: queue, matmul or alloc\n"
+        << "  --json FILE         write results as JSON\n"
+        << "  --baseline FILE     compare against a previous --json output\n"
+        << "  --threshold F       relative regression threshold (default 0.10)\n";
+}
+
+Options parse_args(int argc, char** argv) {
+    Options o;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument("missing value for " + a);
+            return argv[++i];
+        };
+        if (a == "--iters") o.iterations = std::stoul(next());
+        else if (a == "--reps") o.reps = std::max(1, std::stoi(next()));
+        else if (a == "--caps") o.capacities = parse_sizes(next());
+        else if (a == "--payloads") o.payloads = parse_sizes(next());
+        else if (a == "--cpus") o.cpus = parse_cpus(next());
+        else if (a == "--shapes") o.shapes = parse_shapes(next());
+        else if (a == "--alloc-cap") o.alloc_capacity = std::stoul(next());
+        else if (a == "--alloc-shape") o.alloc_shape = parse_shapes(next()).at(0);
+        else if (a == "--json") o.json_path = next();
+        else if (a == "--baseline") o.baseline_path = next();
+        else if (a == "--threshold") o.threshold = std::stod(next());
+        else if (a == "--only") {
+            std::string g = next();
+            o.run_queues = (g == "queue");
+            o.run_matmul = (g == "matmul");
+            o.run_alloc = (g == "alloc");
+            if (!o.run_queues && !o.run_matmul && !o.run_alloc) throw std::invalid_argument("unknown group " + g);
+        }
+        else if (a == "-h" || a == "--help") { usage(argv[0]); std::exit(0); }
+        else throw std::invalid_argument("unknown option " + a);
+    }
+    // A single slot has no usable capacity, and zero sizes divide by zero in the timings.
+    if (o.iterations == 0) throw std::invalid_argument("--iters must be > 0");
+    if (o.alloc_capacity < 2) throw std::invalid_argument("--alloc-cap must be >= 2");
+    for (size_t c : o.capacities)
+        if (c < 2) throw std::invalid_argument("--caps entries must be >= 2, got " + std::to_string(c));
+    auto check_shape = [](const Shape& s) {
+        if (s.M == 0 || s.N == 0 || s.K == 0) throw std::invalid_argument("matmul dimensions must be > 0");
+    };
+    for (const auto& s : o.shapes) check_shape(s);
+    check_shape(o.alloc_shape);
+    for (const auto& c : o.cpus)
+        for (int cpu : {c.producer, c.consumer})
+            if (!bench::cpu_allowed(cpu))
+                throw std::invalid_argument("cpu " + std::to_string(cpu) +
+                                            " is not in this process's affinity mask (use -1 for unpinned)");
+    if (o.cpus.empty()) {
+        // Neighbouring cpus, plus the far end of the mask (often another core complex or socket).
+        // With a single cpu the pair collapses and the cross-thread cases are skipped.
+        const auto cpus = bench::allowed_cpus();
+        if (cpus.empty()) o.cpus = {{-1, -1}};
+        else if (cpus.size() == 1) o.cpus = {{cpus[0], cpus[0]}};
+        else {
+            o.cpus = {{cpus[0], cpus[1]}};
+            if (cpus.size() > 2) o.cpus.push_back({cpus[0], cpus.back()});
+        }
+    }
+    return o;
+}
+
+// --- measurement ---
+
+double median(std::vector<double> v) {
+    std::sort(v.begin(), v.end());
+    return v[v.size() / 2];
+}
+
+std::string cpu_tag(const CpuPair& c) {
+    return std::to_string(c.producer) + ":" + std::to_string(c.consumer);
+}
+
+// Two busy-spinning threads pinned to one cpu measure scheduler time slices, not the queue.
+bool shares_cpu(const CpuPair& c) {
+    return c.producer >= 0 && c.producer == c.consumer;
+}
+
+void warn_shared_cpu(const std::string& name) {
+    std::cerr << "[WARN] producer and consumer share a cpu, skipping " << name << "\n";
+}
+
+void warn_unpinned(const std::string& name) {
+    std::cerr << "[WARN] cpu pinning failed, skipping " << name << "\n";
+}
+
+// Records a case, or skips it if the measurement could not be pinned as its name says.
+void record(std::vector<Record>& out, const std::string& name, const std::string& metric,
+            const std::optional<double>& value, bool lower_is_better) {
+    if (value) out.push_back({name, metric, *value, lower_is_better});
+    else warn_unpinned(name);
+}
+
+// Median of `reps` runs; nullopt if any run could not pin its threads.
+template<typename Queue, typename P>
+std::optional<double> median_ns_per_op(bench::Mode mode, const bench::QueueConfig& cfg, int reps,
+                                       const typename Queue::allocator_type& alloc = {}) {
+    std::vector<double> samples;
+    if (!bench::measure_queue<Queue, P>(mode, cfg, alloc).pinned) return std::nullopt; // warm-up
+    for (int r = 0; r < reps; ++r) {
+        auto res = bench::measure_queue<Queue, P>(mode, cfg, alloc);
+        if (!res.pinned) return std::nullopt;
+        samples.push_back(res.ns_per_op);
+    }
+    return median(samples);
+}
+
+template<typename P>
+void run_queue_cases(const Options& o, size_t payload, std::vector<Record>& out) {
+    for (size_t cap : o.capacities) {
+        bench::QueueConfig cfg;
+        cfg.iterations = o.iterations;
+        cfg.producer_cpu = o.cpus.front().producer;
+
+        // `cap` is the number of storage slots for both containers: RingBufferFixed(n)
+        // allocates n slots, SPSCQueue(n) allocates n + 1. Both keep cap - 1 usable, and
+        // a power-of-two cap exercises the mask path in each.
+        const std::string suffix = "/slots=" + std::to_string(cap) + "/payload=" + std::to_string(payload);
+
+        cfg.capacity = cap;
+        record(out, "ring_st" + suffix, "ns_per_op",
+               median_ns_per_op<RingBufferFixed<P>, P>(bench::Mode::SingleThread, cfg, o.reps), true);
+        cfg.capacity = cap - 1;
+        record(out, "spsc_st" + suffix, "ns_per_op",
+               median_ns_per_op<SPSCQueue<P>, P>(bench::Mode::SingleThread, cfg, o.reps), true);
+
+        for (const auto& c : o.cpus) {
+            const std::string name = "spsc" + suffix + "/cpu=" + cpu_tag(c);
+            if (shares_cpu(c)) {
+                warn_shared_cpu(name);
+                continue;
+            }
+            cfg.producer_cpu = c.producer;
+            cfg.consumer_cpu = c.consumer;
+            record(out, name, "ns_per_op",
+                   median_ns_per_op<SPSCQueue<P>, P>(bench::Mode::SPSC, cfg, o.reps), true);
+        }
+    }
+}
+
+void run_queues(const Options& o, std::vector<Record>& out) {
+    for (size_t p : o.payloads) {
+        switch (p) {
+            case 8:   run_queue_cases<Payload<8>>(o, p, out); break;
+            case 16:  run_queue_cases<Payload<16>>(o, p, out); break;
+            case 64:  run_queue_cases<Payload<64>>(o, p, out); break;
+            case 256: run_queue_cases<Payload<256>>(o, p, out); break;
+            default:
+                std::cerr << "[WARN] unsupported payload size " << p << ", skipping\n";
+        }
+    }
+}
+
+using MatFn = void (*)(const double*, const double*, double*, size_t, size_t, size_t);
+
+void run_matmul(const Options& o, std::vector<Record>& out) {
+    const std::vector<std::pair<std::string, MatFn>> variants = {
+        {"ijk", tachyon::linalg::mm_ijk<double>},
+        {"jik", tachyon::linalg::mm_jik<double>},
+        {"jki", tachyon::linalg::mm_jki<double>},
+        {"kji", tachyon::linalg::mm_kji<double>},
+        {"kij", tachyon::linalg::mm_kij<double>},
+        {"ikj", tachyon::linalg::mm_ikj<double>},
+    };
+
+    // Matmul is single threaded; keep it on the producer cpu of the first pair.
+    std::thread worker([&] {
+        if (!bench::pin_this_thread(o.cpus.front().producer)) {
+            warn_unpinned("matmul group");
+            return;
+        }
+        std::mt19937_64 rng(42);
+        std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+        for (const auto& s : o.shapes) {
+            std::vector<double> A(s.M * s.K), B(s.K * s.N), BT(s.N * s.K), C(s.M * s.N);
+            for (auto& a : A) a = dist(rng);
+            for (auto& b : B) b = dist(rng);
+            tachyon::linalg::transpose(B.data(), BT.data(), s.K, s.N);
+
+            const std::string shape = std::to_string(s.M) + "x" + std::to_string(s.N) + "x" + std::to_string(s.K);
+            const double flops = 2.0 * double(s.M) * double(s.N) * double(s.K);
+
+            auto time_gflops = [&](auto&& fn) {
+                fn(); // warm-up
+                std::vector<double> samples;
+                for (int r = 0; r < o.reps; ++r) {
+                    auto t0 = std::chrono::high_resolution_clock::now();
+                    fn();
+                    auto t1 = std::chrono::high_resolution_clock::now();
+                    std::chrono::duration<double> d = t1 - t0;
+                    samples.push_back(flops / 1e9 / d.count());
+                }
+                return median(samples);
+            };
+
+            for (const auto& v : variants) {
+                double gf = time_gflops([&] { v.second(A.data(), B.data(), C.data(), s.M, s.N, s.K); });
+                out.push_back({"matmul/" + v.first + "/" + shape, "gflops", gf, false});
+            }
+            double gf = time_gflops([&] {
+                tachyon::linalg::mm_ijk_Bt(A.data(), BT.data(), C.data(), s.M, s.N, s.K);
+            });
+            out.push_back({"matmul/ijk_Bt/" + shape, "gflops", gf, false});
+        }
+    });
+    worker.join();
+}
+
+// --- allocators ---
+
+// Fill the whole queue, then drain it, so every slot (and page) is touched each round.
+template<typename Queue, typename P>
+double fill_drain_ns_per_op(size_t capacity, size_t iterations, const typename Queue::allocator_type& alloc) {
+    Queue q(capacity, alloc);
+    const size_t rounds = std::max<size_t>(1, iterations / capacity);
+    P out;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (size_t r = 0; r < rounds; ++r) {
+        for (size_t i = 0; i < capacity; ++i) q.try_push(static_cast<P>(i));
+        for (size_t i = 0; i < capacity; ++i) q.try_pop(out);
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::nano> d = t1 - t0;
+    return d.count() / double(rounds * capacity * 2);
+}
+
+template<typename Alloc>
+void run_alloc_case(const Options& o, const std::string& tag, const Alloc& alloc, std::vector<Record>& out) {
+    using P = Payload<64>;
+    using QAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<P>;
+    using Queue = SPSCQueue<P, QAlloc>;
+    const QAlloc qalloc(alloc);
+    // Same slot convention as the queue group: alloc_capacity slots, one kept empty.
+    const size_t usable = o.alloc_capacity - 1;
+    const std::string cap = "/slots=" + std::to_string(o.alloc_capacity);
+
+    std::optional<double> fill;
+    std::thread worker([&] {
+        if (!bench::pin_this_thread(o.cpus.front().producer)) return;
+        std::vector<double> samples;
+        fill_drain_ns_per_op<Queue, P>(usable, o.iterations, qalloc); // warm-up
+        for (int r = 0; r < o.reps; ++r)
+            samples.push_back(fill_drain_ns_per_op<Queue, P>(usable, o.iterations, qalloc));
+        fill = median(samples);
+    });
+    worker.join();
+    record(out, "alloc/" + tag + "/spsc_fill" + cap, "ns_per_op", fill, true);
+
+    bench::QueueConfig cfg;
+    cfg.capacity = usable;
+    cfg.iterations = o.iterations;
+    cfg.producer_cpu = o.cpus.front().producer;
+    cfg.consumer_cpu = o.cpus.front().consumer;
+    const std::string spsc_name = "alloc/" + tag + "/spsc" + cap + "/cpu=" + cpu_tag(o.cpus.front());
+    if (shares_cpu(o.cpus.front()))
+        warn_shared_cpu(spsc_name);
+    else
+        record(out, spsc_name, "ns_per_op",
+               median_ns_per_op<Queue, P>(bench::Mode::SPSC, cfg, o.reps, qalloc), true);
+
+    using DAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<double>;
+    const DAlloc dalloc(alloc);
+    const Shape s = o.alloc_shape;
+    const std::string mm_name = "alloc/" + tag + "/matmul_ikj/" + std::to_string(s.M) + "x" +
+                                std::to_string(s.N) + "x" + std::to_string(s.K);
+    std::optional<double> gflops;
+    std::thread mm([&] {
+        if (!bench::pin_this_thread(o.cpus.front().consumer)) return;
+        std::vector<double, DAlloc> A(s.M * s.K, 1.0, dalloc), B(s.K * s.N, 0.5, dalloc), C(s.M * s.N, 0.0, dalloc);
+        const double flops = 2.0 * double(s.M) * double(s.N) * double(s.K);
+        tachyon::linalg::mm_ikj(A.data(), B.data(), C.data(), s.M, s.N, s.K); // warm-up
+        std::vector<double> gf;
+        for (int r = 0; r < o.reps; ++r) {
+            auto t0 = std::chrono::high_resolution_clock::now();
+            tachyon::linalg::mm_ikj(A.data(), B.data(), C.data(), s.M, s.N, s.K);
+            auto t1 = std::chrono::high_resolution_clock::now();
+            std::chrono::duration<double> d = t1 - t0;
+            gf.push_back(flops / 1e9 / d.count());
+        }
+        gflops = median(gf);
+    });
+    mm.join();
+    record(out, mm_name, "gflops", gflops, false);
+}
+
+void run_alloc(const Options& o, std::vector<Record>& out) {
+    // Bind to the consumer's node; matmul also runs there.
+    const int node = Tachyon::memory::node_of_cpu(o.cpus.front().consumer);
+    run_alloc_case(o, "std", std::allocator<char>(), out);
+    run_alloc_case(o, "aligned64", AlignedAllocator<char, 64>(), out);
+    run_alloc_case(o, "thp", AlignedAllocator<char, 64, PageMode::Transparent>(), out);
+    // Explicit falls back to THP with an empty pool; label the rows by what was measured.
+    std::string hugetlb = "hugetlb";
+    if (!Tachyon::memory::hugetlb_available()) {
+        std::cerr << "[WARN] hugetlbfs pool is empty (vm.nr_hugepages), measuring hugetlb_fallback_thp\n";
+        hugetlb = "hugetlb_fallback_thp";
+    }
+    run_alloc_case(o, hugetlb, AlignedAllocator<char, 64, PageMode::Explicit>(), out);
+
+    if (node < 0) {
+        std::cerr << "[WARN] consumer cpu " << o.cpus.front().consumer
+                  << " is unpinned or has no known NUMA node, skipping thp_node cases\n";
+        return;
+    }
+
+    // Probe the policy once; if mbind is rejected the case would just repeat "thp".
+    AlignedAllocator<char, 64, PageMode::Transparent> bound(node);
+    bound.deallocate(bound.allocate(1), 1);
+    if (bound.node_bound())
+        run_alloc_case(o, "thp_node" + std::to_string(node), bound, out);
+    else
+        std::cerr << "[WARN] mbind to node " << node << " failed, skipping thp_node" << node << " cases\n";
+}
+
+// --- JSON I/O ---
+
+std::string json_escape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+void write_json(const std::string& path, const Options& o, const std::vector<Record>& recs) {
+    std::ofstream f(path);
+    if (!f) throw std::runtime_error("cannot open " + path);
+    f << std::setprecision(6);
+    f << "{\n";
+    f << "  \"timestamp\": " << static_cast<long long>(std::time(nullptr)) << ",\n";
+    f << "  \"cpus\": " << bench::hardware_cpus() << ",\n";
+    f << "  \"iterations\": " << o.iterations << ",\n";
+    f << "  \"reps\": " << o.reps << ",\n";
+    f << "  \"results\": [\n";
+    for (size_t i = 0; i < recs.size(); ++i) {
+        const auto& r = recs[i];
+        f << "    {\"name\": \"" << json_escape(r.name) << "\", \"metric\": \"" << r.metric
+          << "\", \"value\": " << r.value
+          << ", \"lower_is_better\": " << (r.lower_is_better ? "true" : "false") << "}"
+          << (i + 1 < recs.size() ? "," : "") << "\n";
+    }
+    f << "  ]\n}\n";
+}
+
+struct Baseline {
+    std::map<std::string, double> values;
+    // Run parameters from the header; -1 if the file predates them.
+    long long iterations = -1;
+    long long reps = -1;
+    long long cpus = -1;
+};
+
+// Top-level numeric field `key` of a write_json file, or -1 if absent.
+long long header_number(const std::string& text, const std::string& key) {
+    const size_t results = text.find("\"results\"");
+    const size_t k = text.find("\"" + key + "\"");
+    if (k == std::string::npos || k > results) return -1;
+    return std::strtoll(text.c_str() + text.find(':', k) + 1, nullptr, 10);
+}
+
+// Reads back the flat result objects produced by write_json; not a general JSON parser.
+Baseline read_baseline(const std::string& path) {
+    std::ifstream f(path);
+    if (!f) throw std::runtime_error("cannot open " + path);
+    std::stringstream ss;
+    ss << f.rdbuf();
+    const std::string text = ss.str();
+
+    Baseline base;
+    base.iterations = header_number(text, "iterations");
+    base.reps = header_number(text, "reps");
+    base.cpus = header_number(text, "cpus");
+
+    auto& out = base.values;
+    size_t pos = text.find("\"results\"");
+    if (pos == std::string::npos) return base;
+    while ((pos = text.find('{', pos)) != std::string::npos) {
+        size_t end = text.find('}', pos);
+        if (end == std::string::npos) break;
+        const std::string obj = text.substr(pos, end - pos);
+        pos = end;
+
+        size_t k = obj.find("\"name\"");
+        size_t v = obj.find("\"value\"");
+        if (k == std::string::npos || v == std::string::npos) continue;
+        size_t q0 = obj.find('"', obj.find(':', k) + 1);
+        size_t q1 = q0;
+        do { q1 = obj.find('"', q1 + 1); } while (q1 != std::string::npos && obj[q1 - 1] == '\\');
+        if (q0 == std::string::npos || q1 == std::string::npos) continue;
+        std::string name;
+        for (size_t i = q0 + 1; i < q1; ++i) {
+            if (obj[i] == '\\' && i + 1 < q1) ++i;
+            name += obj[i];
+        }
+        out[name] = std::strtod(obj.c_str() + obj.find(':', v) + 1, nullptr);
+    }
+    return base;
+}
+
+// Numbers from different iteration counts, repetitions or machines are not comparable.
+void check_baseline_params(const Baseline& base, const Options& o) {
+    auto check = [](const char* what, long long recorded, long long current) {
+        if (recorded < 0) {
+            std::cerr << "[WARN] baseline does not record " << what << ", cannot verify it matches\n";
+            return;
+        }
+        if (recorded != current)
+            throw std::runtime_error(std::string("baseline was recorded with ") + what + "=" +
+                                     std::to_string(recorded) + ", this run uses " + std::to_string(current) +
+                                     "; re-record the baseline or match the settings");
+    };
+    check("iterations", base.iterations, static_cast<long long>(o.iterations));
+    check("reps", base.reps, o.reps);
+    check("cpus", base.cpus, bench::hardware_cpus());
+}
+
+struct Comparison {
+    int regressions = 0;
+    int missing = 0;
+};
+
+// Prints a comparison table. Cases present on only one side are listed as "new"
+// or "missing"; missing ones fail the gate so a shrinking suite is visible.
+Comparison compare(const std::vector<Record>& recs, const std::map<std::string, double>& base, double threshold) {
+    int regressions = 0, added = 0, missing = 0;
+    std::map<std::string, bool> seen;
+    std::cout << "\nBaseline comparison (threshold " << threshold * 100.0 << "%)\n";
+    std::cout << std::string(96, '-') << "\n";
+    for (const auto& r : recs) {
+        seen[r.name] = true;
+        auto it = base.find(r.name);
+        if (it == base.end()) {
+            ++added;
+            std::cout << std::left << std::setw(48) << r.name
+                      << std::right << std::setw(14) << "-"
+                      << std::setw(14) << std::setprecision(4) << r.value << "            new\n";
+            continue;
+        }
+        if (it->second <= 0.0) continue;
+        // Positive change = worse, regardless of metric direction.
+        double change = (r.value - it->second) / it->second;
+        if (!r.lower_is_better) change = -change;
+        const bool regressed = change > threshold;
+        regressions += regressed;
+        std::cout << std::left << std::setw(48) << r.name
+                  << std::right << std::setw(14) << std::setprecision(4) << it->second
+                  << std::setw(14) << r.value
+                  << std::setw(10) << std::fixed << std::setprecision(1) << change * 100.0 << "%"
+                  << (regressed ? "  REGRESSION" : "") << "\n";
+        std::cout.unsetf(std::ios::fixed);
+    }
+    for (const auto& [name, value] : base) {
+        if (seen.count(name)) continue;
+        ++missing;
+        std::cout << std::left << std::setw(48) << name
+                  << std::right << std::setw(14) << std::setprecision(4) << value
+                  << std::setw(14) << "-" << "            missing\n";
+    }
+    if (added || missing)
+        std::cerr << "\n[WARN] " << missing << " baseline case(s) missing from this run, "
+                  << added << " case(s) not in the baseline\n";
+    return {regressions, missing};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options o;
+    try {
+        o = parse_args(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] " << e.what() << "\n";
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<Record> recs;
+    if (o.run_queues) run_queues(o, recs);
+    if (o.run_matmul) run_matmul(o, recs);
+    if (o.run_alloc) run_alloc(o, recs);
+
+    std::cout << std::left << std::setw(48) << "Case"
+              << std::right << std::setw(14) << "Value" << "  Metric\n";
+    std::cout << std::string(72, '-') << "\n";
+    for (const auto& r : recs)
+        std::cout << std::left << std::setw(48) << r.name
+                  << std::right << std::setw(14) << std::setprecision(4) << r.value
+                  << "  " << r.metric << "\n";
+
+    try {
+        if (!o.json_path.empty()) write_json(o.json_path, o, recs);
+        if (!o.baseline_path.empty()) {
+            const Baseline base = read_baseline(o.baseline_path);
+            check_baseline_params(base, o);
+            const Comparison c = compare(recs, base.values, o.threshold);
+            if (c.regressions > 0) {
+                std::cerr << "\n" << c.regressions << " case(s) regressed beyond " << o.threshold * 100.0 << "%\n";
+                return 2;
+            }
+            if (c.missing > 0) {
+                std::cerr << "\n" << c.missing << " baseline case(s) were not measured\n";
+                return 3;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
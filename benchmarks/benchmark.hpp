@@ -1,16 +1,18 @@
 #pragma once
 #include <chrono>
 #include <iostream>
-#include <string>
-
-#pragma once
-#include <chrono>
-#include <iostream>
+#include <memory>
 #include <string>
 #include <thread>
 #include <atomic>
 #include <functional>
 #include <cassert>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 namespace bench {
 
@@ -20,6 +22,15 @@ struct Result {
     double seconds;
     double ops_per_sec;
     double ns_per_op;
+    bool pinned = true; // false if any requested cpu pin was rejected
+};
+
+// Queue run parameters. A cpu of -1 leaves the thread unpinned.
+struct QueueConfig {
+    size_t capacity = 1024;
+    size_t iterations = 10'000'000;
+    int producer_cpu = -1;
+    int consumer_cpu = -1;
 };
 
 inline void print_result(const std::string& name, const Result& r) {
@@ -29,6 +40,45 @@ inline void print_result(const std::string& name, const Result& r) {
     std::cout << "  ns/op: " << r.ns_per_op << "\n\n";
 }
 
+// Pin the calling thread to a single cpu; returns false if unsupported or rejected.
+inline bool pin_this_thread(int cpu) {
+    if (cpu < 0) return true;
+#if defined(__linux__)
+    if (cpu >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+// Cpus this process may run on (its affinity mask); empty if pinning is unsupported.
+inline std::vector<int> allowed_cpus() {
+    std::vector<int> out;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0) return out;
+    for (int c = 0; c < CPU_SETSIZE; ++c)
+        if (CPU_ISSET(c, &set)) out.push_back(c);
+#endif
+    return out;
+}
+
+inline bool cpu_allowed(int cpu) {
+    if (cpu < 0) return true;
+    for (int c : allowed_cpus())
+        if (c == cpu) return true;
+    return false;
+}
+
+inline unsigned hardware_cpus() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n ? n : 1;
+}
+
 template<typename SetupFunc, typename RunFunc>
 Result run_once(SetupFunc&& setup, RunFunc&& run, size_t ops) {
     setup();
@@ -43,46 +93,65 @@ Result run_once(SetupFunc&& setup, RunFunc&& run, size_t ops) {
     return {seconds, ops_per_sec, ns_per_op};
 }
 
-// Benchmark a queue-like type in different modes
-template<typename Queue>
-void run_queue_benchmark(const std::string& name, Mode mode, size_t iterations) {
+// Time one pass of a queue-like type. Payload must be constructible from size_t
+// via static_cast. SingleThread runs on producer_cpu; SPSC pins each side and builds
+// the queue on consumer_cpu, so its pages are placed by first touch on the consumer's node.
+template<typename Queue, typename Payload = int>
+Result measure_queue(Mode mode, const QueueConfig& cfg,
+                     const typename Queue::allocator_type& alloc = {}) {
+    std::unique_ptr<Queue> q;
+    auto setup = [&] { q.reset(); q = std::make_unique<Queue>(cfg.capacity, alloc); };
+    const size_t iterations = cfg.iterations;
+    Result res{};
+
     if (mode == Mode::SingleThread) {
-        Queue q(1024);
-        // Warm-up and timing
-        auto res = run_once(
-            [&] { new(&q) Queue(1024); }, // setup
-            [&] {
-                int out;
-                for (size_t i = 0; i < iterations; ++i) {
-                    while (!q.try_push(static_cast<int>(i))) {}
-                    while (!q.try_pop(out)) {}
-                }
-            },
-            iterations * 2 // push + pop per iteration
-        );
-        print_result(name + " [SingleThread]", res);
+        // Run on a dedicated thread so pinning does not leak into the caller.
+        std::thread worker([&] {
+            const bool pinned = pin_this_thread(cfg.producer_cpu);
+            res = run_once(
+                setup,
+                [&] {
+                    Payload out;
+                    for (size_t i = 0; i < iterations; ++i) {
+                        while (!q->try_push(static_cast<Payload>(i))) {}
+                        while (!q->try_pop(out)) {}
+                    }
+                },
+                iterations * 2 // push + pop per iteration
+            );
+            res.pinned = pinned;
+        });
+        worker.join();
     }
     else if (mode == Mode::SPSC) {
-        Queue q(1024);
         std::atomic<bool> start_flag{false};
         std::atomic<size_t> produced{0}, consumed{0};
+        bool setup_pinned = false, prod_pinned = false, cons_pinned = false;
 
-        auto res = run_once(
-            [&] { new(&q) Queue(1024); }, // setup
+        res = run_once(
+            [&] {
+                std::thread builder([&] {
+                    setup_pinned = pin_this_thread(cfg.consumer_cpu);
+                    setup();
+                });
+                builder.join();
+            },
             [&] {
                 std::thread prod([&] {
+                    prod_pinned = pin_this_thread(cfg.producer_cpu);
                     while (!start_flag.load(std::memory_order_acquire)) {}
                     for (size_t i = 0; i < iterations; ++i) {
-                        while (!q.try_push(static_cast<int>(i))) {}
+                        while (!q->try_push(static_cast<Payload>(i))) {}
                         produced.fetch_add(1, std::memory_order_relaxed);
                     }
                 });
 
                 std::thread cons([&] {
-                    int out;
+                    cons_pinned = pin_this_thread(cfg.consumer_cpu);
+                    Payload out;
                     while (!start_flag.load(std::memory_order_acquire)) {}
                     for (size_t i = 0; i < iterations; ++i) {
-                        while (!q.try_pop(out)) {}
+                        while (!q->try_pop(out)) {}
                         consumed.fetch_add(1, std::memory_order_relaxed);
                     }
                 });
@@ -93,10 +162,19 @@ void run_queue_benchmark(const std::string& name, Mode mode, size_t iterations)
             },
             iterations * 2 // push + pop per iteration
         );
-        print_result(name + " [SPSC]", res);
+        res.pinned = setup_pinned && prod_pinned && cons_pinned;
         assert(produced == iterations && consumed == iterations && "Mismatch in produced/consumed counts!");
     }
+    return res;
 }
 
-} // namespace bench
+// Benchmark a queue-like type in different modes
+template<typename Queue>
+void run_queue_benchmark(const std::string& name, Mode mode, size_t iterations) {
+    QueueConfig cfg;
+    cfg.iterations = iterations;
+    auto res = measure_queue<Queue>(mode, cfg);
+    print_result(name + (mode == Mode::SPSC ? " [SPSC]" : " [SingleThread]"), res);
+}
 
+} // namespace bench
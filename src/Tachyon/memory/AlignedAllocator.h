@@ -0,0 +1,207 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__linux__)
+#include <filesystem>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Tachyon::memory {
+
+inline constexpr size_t kCacheLine = 64;
+inline constexpr size_t kHugePage = 2 * 1024 * 1024;
+
+// How the backing pages are obtained.
+//   None        - aligned operator new, regular pages
+//   Transparent - mmap, 2 MB aligned, madvise(MADV_HUGEPAGE)
+//   Explicit    - mmap(MAP_HUGETLB) from the hugetlbfs pool, Transparent if the pool is empty
+//                 (see hugetlb_available())
+enum class PageMode { None, Transparent, Explicit };
+
+// NUMA node owning a cpu, or -1 if unknown (non-Linux, no sysfs, single node kernels).
+inline int node_of_cpu(int cpu) {
+#if defined(__linux__)
+    if (cpu < 0) return -1;
+    std::error_code ec;
+    const std::filesystem::path dir = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+    for (const auto& e : std::filesystem::directory_iterator(dir, ec)) {
+        const std::string name = e.path().filename().string();
+        if (name.size() > 4 && name.compare(0, 4, "node") == 0)
+            return std::stoi(name.substr(4));
+    }
+#endif
+    (void)cpu;
+    return -1;
+}
+
+namespace detail {
+
+#if defined(__linux__)
+// MAP_HUGETLB alone uses the kernel's default huge page size (possibly 1 GB);
+// request 2 MB pages explicitly so lengths match kHugePage.
+#if defined(MAP_HUGE_SHIFT)
+inline constexpr int kMapHuge2MB = MAP_HUGETLB | (21 << MAP_HUGE_SHIFT);
+#else
+inline constexpr int kMapHuge2MB = MAP_HUGETLB | (21 << 26);
+#endif
+
+inline size_t round_up(size_t n, size_t to) { return (n + to - 1) / to * to; }
+
+// Prefer (not require) pages from `node`; the kernel falls back when the node is full.
+// Returns false if the policy was rejected (bad node, no NUMA support, EPERM in a container).
+inline bool prefer_node(void* p, size_t len, int node) {
+    if (node < 0) return false;
+    constexpr int kMpolPreferred = 1;
+    constexpr size_t kBits = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> mask(static_cast<size_t>(node) / kBits + 1, 0);
+    mask[static_cast<size_t>(node) / kBits] |= 1UL << (static_cast<size_t>(node) % kBits);
+    return syscall(SYS_mbind, p, len, kMpolPreferred, mask.data(), mask.size() * kBits + 1, 0) == 0;
+}
+
+// Anonymous mapping of `len` bytes aligned to `align` (a multiple of the page size).
+inline void* map_aligned(size_t len, size_t align) {
+    const size_t span = len + align;
+    void* raw = mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) return nullptr;
+    const auto base = reinterpret_cast<uintptr_t>(raw);
+    const uintptr_t start = (base + align - 1) & ~(uintptr_t(align) - 1);
+    if (start > base) munmap(raw, start - base);
+    const uintptr_t tail = start + len;
+    if (base + span > tail) munmap(reinterpret_cast<void*>(tail), base + span - tail);
+    return reinterpret_cast<void*>(start);
+}
+#endif
+
+} // namespace detail
+
+// True if a 2 MB page can currently be reserved from the hugetlbfs pool
+// (/proc/sys/vm/nr_hugepages). When false, PageMode::Explicit gets Transparent pages.
+inline bool hugetlb_available() {
+#if defined(__linux__)
+    void* p = mmap(nullptr, kHugePage, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | detail::kMapHuge2MB, -1, 0);
+    if (p == MAP_FAILED) return false;
+    munmap(p, kHugePage);
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Allocator with configurable alignment, huge-page backing and NUMA placement.
+// Usable with std::vector and with the queue/ring containers:
+//
+//   using Alloc = AlignedAllocator<Msg, kCacheLine, PageMode::Transparent>;
+//   SPSCQueue<Msg, Alloc> q(1 << 20, Alloc(node_of_cpu(consumer_cpu)));
+//
+// Without a node, placement follows first touch: construct the container on the
+// thread (or cpu) that will use it most. Binding is best effort; node_bound() on
+// the container's get_allocator() tells whether the last allocation took the policy.
+template <class T, size_t Align = kCacheLine, PageMode Pages = PageMode::None>
+class AlignedAllocator {
+    static_assert((Align & (Align - 1)) == 0, "Align must be a power of two");
+    // MAP_HUGETLB mappings are only 2 MB aligned; Transparent over-maps and trims instead.
+    static_assert(Pages != PageMode::Explicit || Align <= kHugePage,
+                  "PageMode::Explicit cannot align beyond kHugePage");
+
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    static constexpr size_t alignment = Align < alignof(T) ? alignof(T) : Align;
+    static constexpr PageMode pages = Pages;
+
+    template <class U>
+    struct rebind { using other = AlignedAllocator<U, Align, Pages>; };
+
+    AlignedAllocator() noexcept = default;
+    explicit AlignedAllocator(int numa_node) noexcept : node_(numa_node) {}
+
+    template <class U>
+    AlignedAllocator(const AlignedAllocator<U, Align, Pages>& other) noexcept : node_(other.numa_node()) {}
+
+    int numa_node() const noexcept { return node_; }
+    bool node_bound() const noexcept { return bound_; }
+
+    T* allocate(size_t n) {
+        if (n > size_t(-1) / sizeof(T)) throw std::bad_array_new_length();
+        const size_t bytes = n * sizeof(T);
+#if defined(__linux__)
+        if (use_mmap()) {
+            const size_t len = mapped_length(bytes);
+            void* p = nullptr;
+            if (Pages == PageMode::Explicit) {
+                p = mmap(nullptr, len, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | detail::kMapHuge2MB, -1, 0);
+                if (p == MAP_FAILED) p = nullptr;
+            }
+            if (!p) {
+                p = detail::map_aligned(len, map_align());
+                if (!p) throw std::bad_alloc();
+                if (Pages != PageMode::None) madvise(p, len, MADV_HUGEPAGE);
+            }
+            bound_ = detail::prefer_node(p, len, node_);
+            return static_cast<T*>(p);
+        }
+#endif
+        return static_cast<T*>(::operator new(bytes, std::align_val_t(alignment)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (!p) return;
+#if defined(__linux__)
+        if (use_mmap()) {
+            [[maybe_unused]] const int rc = munmap(p, mapped_length(n * sizeof(T)));
+            assert(rc == 0 && "munmap length does not match the mapping");
+            return;
+        }
+#endif
+        ::operator delete(p, std::align_val_t(alignment));
+        (void)n;
+    }
+
+private:
+#if defined(__linux__)
+    bool use_mmap() const noexcept { return Pages != PageMode::None || node_ >= 0; }
+
+    static size_t page_size() noexcept {
+        static const size_t ps = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return ps;
+    }
+
+    size_t map_align() const noexcept {
+        size_t a = Pages == PageMode::None ? page_size() : kHugePage;
+        return a < alignment ? alignment : a;
+    }
+
+    // Same length for allocate and deallocate; huge-page modes round to whole 2 MB pages.
+    size_t mapped_length(size_t bytes) const noexcept {
+        return detail::round_up(bytes ? bytes : 1, Pages == PageMode::None ? page_size() : kHugePage);
+    }
+#endif
+
+    int node_ = -1;
+    bool bound_ = false;
+};
+
+template <class T, class U, size_t A, PageMode P>
+bool operator==(const AlignedAllocator<T, A, P>& a, const AlignedAllocator<U, A, P>& b) noexcept {
+    return a.numa_node() == b.numa_node();
+}
+
+template <class T, class U, size_t A, PageMode P>
+bool operator!=(const AlignedAllocator<T, A, P>& a, const AlignedAllocator<U, A, P>& b) noexcept {
+    return !(a == b);
+}
+
+} // namespace Tachyon::memory
@@ -8,19 +8,22 @@
 
 namespace Tachyon::queues {
 
-template <class T>
+template <class T, class Alloc = std::allocator<T>>
 class SPSCQueue {
 public:
-    explicit SPSCQueue(size_t capacity)
+    using allocator_type = Alloc;
+
+    explicit SPSCQueue(size_t capacity, const Alloc& alloc = Alloc())
         : cap_(capacity + 1),
         is_pot_((cap_ & (cap_ - 1)) == 0),
         mask_(is_pot_ ? (cap_ - 1) : 0),
-        storage_(cap_) {
+        storage_(cap_, alloc) {
             head_.store(0, std::memory_order_relaxed);
             tail_.store(0, std::memory_order_relaxed);
     }
 
     size_t capacity() const noexcept { return cap_ - 1; }
+    allocator_type get_allocator() const { return storage_.get_allocator(); }
 
     bool try_push(const T& v) { return do_push(v); }
     bool try_push(T&& v) { return do_push(std::move(v)); }
@@ -77,7 +80,7 @@ private:
     size_t cap_;
     bool is_pot_;
     size_t mask_;
-    std::vector<T> storage_;    // OK for SPSC; produces/consumer touch disjoint indices
+    std::vector<T, Alloc> storage_;    // OK for SPSC; produces/consumer touch disjoint indices
     std::atomic<size_t> head_, tail_;
 
 
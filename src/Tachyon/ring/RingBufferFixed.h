@@ -1,20 +1,25 @@
 #pragma once
+#include <cstddef>
+#include <memory>
 #include <vector>
 #include <type_traits>
 #include <utility>
 
 namespace Tachyon::ring {
 
-template <class T>
+template <class T, class Alloc = std::allocator<T>>
 class RingBufferFixed {
 public:
-    explicit RingBufferFixed(size_t capacity)
+    using allocator_type = Alloc;
+
+    explicit RingBufferFixed(size_t capacity, const Alloc& alloc = Alloc())
         : cap_(capacity),             
         is_pot_((cap_ & (cap_ - 1)) == 0),
         mask_(is_pot_ ? (cap_ - 1) : 0),
-        buf_(cap_), head_(0), tail_(0) {}
+        buf_(cap_, alloc), head_(0), tail_(0) {}
 
     size_t capacity() const noexcept { return cap_ - 1; }
+    allocator_type get_allocator() const { return buf_.get_allocator(); }
     bool empty()   const noexcept { return head_ == tail_; }
     bool full()    const noexcept { return next_(head_) == tail_; }
 
@@ -64,7 +69,7 @@ private:
     size_t cap_;
     bool   is_pot_;
     size_t mask_;
-    std::vector<T> buf_;
+    std::vector<T, Alloc> buf_;
     size_t head_, tail_;
 };
 
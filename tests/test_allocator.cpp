@@ -0,0 +1,123 @@
+#include <Tachyon/memory/AlignedAllocator.h>
+#include <Tachyon/queues/SPSCQueue.h>
+#include <Tachyon/ring/RingBufferFixed.h>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using Tachyon::memory::AlignedAllocator;
+using Tachyon::memory::kHugePage;
+using Tachyon::memory::PageMode;
+using Tachyon::queues::SPSCQueue;
+using Tachyon::ring::RingBufferFixed;
+
+#define CHECK(expr) do { if(!(expr)) { \
+  std::fprintf(stderr, "CHECK failed: %s at %s:%d\n", #expr, __FILE__, __LINE__); \
+  return 1; } } while(0)
+
+static bool aligned_to(const void* p, std::size_t a) {
+    return reinterpret_cast<std::uintptr_t>(p) % a == 0;
+}
+
+template<class Alloc>
+int test_vector_alignment(std::size_t align, Alloc alloc = Alloc()) {
+    for (std::size_t n : {1u, 3u, 1000u, 300000u}) {
+        std::vector<double, Alloc> v(n, 1.5, alloc);
+        CHECK(aligned_to(v.data(), align));
+        double sum = 0;
+        for (double x : v) sum += x;
+        CHECK(sum == 1.5 * double(n));
+    }
+    return 0;
+}
+
+// Policy of the page at `p`: 1 and bit `node` set for MPOL_PREFERRED(node).
+// Returns -1 if the kernel offers no NUMA policy interface.
+static int preferred_node_bit(const void* p, int node, int& mode) {
+#if defined(__linux__)
+    constexpr int kMpolFAddr = 2;
+    unsigned long mask[16] = {};
+    if (syscall(SYS_get_mempolicy, &mode, mask, sizeof(mask) * 8, p, kMpolFAddr) != 0) return -1;
+    return int((mask[node / 64] >> (node % 64)) & 1UL);
+#else
+    (void)p; (void)node; (void)mode;
+    return -1;
+#endif
+}
+
+int test_node_policy() {
+    using Alloc = AlignedAllocator<double, 64>;
+    std::vector<double, Alloc> v(1000, 2.0, Alloc(0)); // node 0 always exists
+    int mode = -1;
+    const int bit = preferred_node_bit(v.data(), 0, mode);
+    if (bit < 0) {
+        std::fprintf(stderr, "test_node_policy: no NUMA policy support, skipped\n");
+        return 0;
+    }
+    CHECK(v.get_allocator().node_bound());
+    CHECK(mode == 1); // MPOL_PREFERRED
+    CHECK(bit == 1);
+
+    // A node that cannot exist is rejected, and reported, but still allocates.
+    std::vector<double, Alloc> w(1000, 2.0, Alloc(4000));
+    CHECK(!w.get_allocator().node_bound());
+    CHECK(w[999] == 2.0);
+    return 0;
+}
+
+int test_rebind_and_equality() {
+    AlignedAllocator<int, 64> a(0), b(0), c;
+    AlignedAllocator<double, 64> d(a);
+    CHECK(a == b);
+    CHECK(a != c);
+    CHECK(d.numa_node() == 0);
+    return 0;
+}
+
+int test_containers() {
+    using IntAlloc = AlignedAllocator<int, 64, PageMode::Transparent>;
+    SPSCQueue<int, IntAlloc> q(1000);
+    for (int i = 0; i < 1000; ++i) CHECK(q.try_push(i));
+    CHECK(!q.try_push(-1));
+    int out = -1;
+    for (int i = 0; i < 1000; ++i) {
+        CHECK(q.try_pop(out));
+        CHECK(out == i);
+    }
+    CHECK(q.empty());
+
+    using StrAlloc = AlignedAllocator<std::string, 128>;
+    RingBufferFixed<std::string, StrAlloc> rb(8);
+    CHECK(rb.try_push(std::string("a")));
+    CHECK(rb.try_push(std::string("b")));
+    CHECK(aligned_to(rb.peek(), 128));
+    std::string s;
+    CHECK(rb.try_pop(s) && s == "a");
+    CHECK(rb.try_pop(s) && s == "b");
+    return 0;
+}
+
+int main() {
+    using Plain64 = AlignedAllocator<double, 64>;
+    using Page4k = AlignedAllocator<double, 4096>;
+    using Thp = AlignedAllocator<double, 64, PageMode::Transparent>;
+    using Hugetlb = AlignedAllocator<double, 64, PageMode::Explicit>;
+
+    CHECK(test_vector_alignment<Plain64>(64) == 0);
+    CHECK(test_vector_alignment<Page4k>(4096) == 0);
+#if defined(__linux__)
+    // Both huge-page modes hand out whole 2 MB aligned pages, hugetlbfs pool or not.
+    CHECK(test_vector_alignment<Thp>(kHugePage) == 0);
+    CHECK(test_vector_alignment<Hugetlb>(kHugePage) == 0);
+#endif
+    CHECK(test_node_policy() == 0);
+    CHECK(test_rebind_and_equality() == 0);
+    CHECK(test_containers() == 0);
+    return 0;
+}